@@ -0,0 +1,214 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "BoardIO.h"
+
+static const size_t BUFFER_SIZE = 1 << 16; // 64 KiB chunks for the bitmap reader/writer
+
+enum LayoutFormat { TEXT_GRID, BITMAP, COORD_LIST };
+
+static LayoutFormat formatFromPath(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    std::string ext = (dot == std::string::npos) ? "" : path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == "bin") {
+        return BITMAP;
+    }
+    if (ext == "coords" || ext == "csv") {
+        return COORD_LIST;
+    }
+    return TEXT_GRID;
+}
+
+static void clearMines(vector<vector<bool>>& mineLocations, int fieldRows, int numCols) {
+    for (int i = 0; i < fieldRows; ++i) {
+        std::fill(mineLocations[i].begin(), mineLocations[i].begin() + numCols, false);
+    }
+}
+
+static bool loadTextGrid(std::ifstream& in, vector<vector<bool>>& mineLocations, int fieldRows, int numCols, int& numMines) {
+    std::string line;
+    int lineNumber = 0;
+    int row = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (row >= fieldRows) {
+            std::cerr << "Layout line " << lineNumber << ": more than " << fieldRows << " rows" << std::endl;
+            return false;
+        }
+        if ((int)line.size() != numCols) {
+            std::cerr << "Layout line " << lineNumber << ": expected " << numCols << " columns, got " << line.size() << std::endl;
+            return false;
+        }
+        for (size_t col = 0; col < line.size(); ++col) {
+            if (line[col] == '*' || line[col] == '1') {
+                mineLocations[row][col] = true;
+                numMines++;
+            } else if (line[col] != '.' && line[col] != '0') {
+                std::cerr << "Layout line " << lineNumber << ": unexpected '" << line[col] << "' in column " << col << std::endl;
+                return false;
+            }
+        }
+        row++;
+    }
+
+    if (row < fieldRows) {
+        std::cerr << "Layout has " << row << " rows, expected " << fieldRows << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool loadBitmap(std::ifstream& in, vector<vector<bool>>& mineLocations, int fieldRows, int numCols, int& numMines) {
+    std::vector<char> buffer(BUFFER_SIZE);
+    long long totalCells = (long long)fieldRows * numCols;
+    long long cell = 0;
+    bool extraBytes = false;
+
+    // Unpack one chunk at a time straight into mineLocations
+    while (cell < totalCells && in.read(buffer.data(), buffer.size()).gcount() > 0) {
+        std::streamsize bytesRead = in.gcount();
+        std::streamsize b = 0;
+        for (; b < bytesRead && cell < totalCells; ++b) {
+            unsigned char byte = static_cast<unsigned char>(buffer[b]);
+            for (int bit = 0; bit < 8 && cell < totalCells; ++bit, ++cell) {
+                if (byte & (1 << bit)) {
+                    mineLocations[cell / numCols][cell % numCols] = true;
+                    numMines++;
+                }
+            }
+        }
+        extraBytes = b < bytesRead;
+    }
+
+    long long expectedBytes = (totalCells + 7) / 8;
+    if (cell < totalCells) {
+        std::cerr << "Bitmap layout is too short, expected " << expectedBytes << " bytes for a "
+                  << numCols << "x" << fieldRows << " field" << std::endl;
+        return false;
+    }
+    if (extraBytes || in.peek() != std::ifstream::traits_type::eof()) {
+        std::cerr << "Bitmap layout is longer than the " << expectedBytes << " bytes of a "
+                  << numCols << "x" << fieldRows << " field" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool loadCoordList(std::ifstream& in, vector<vector<bool>>& mineLocations, int fieldRows, int numCols, int& numMines) {
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.find_first_not_of(" \t") == std::string::npos || line[0] == '#') {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+        int row, col;
+        std::string extra;
+        if (!(iss >> row >> col) || (iss >> extra)) {
+            std::cerr << "Layout line " << lineNumber << ": expected \"row col\"" << std::endl;
+            return false;
+        }
+        if (row < 0 || col < 0 || row >= fieldRows || col >= numCols) {
+            std::cerr << "Layout line " << lineNumber << ": mine at " << row << "," << col << " is out of bounds" << std::endl;
+            return false;
+        }
+        if (!mineLocations[row][col]) {
+            mineLocations[row][col] = true;
+            numMines++;
+        }
+    }
+    return true;
+}
+
+bool loadLayout(const std::string& path, vector<vector<bool>>& mineLocations, int numRows, int numCols, int& numMines) {
+    LayoutFormat format = formatFromPath(path);
+    std::ifstream in(path, format == BITMAP ? std::ios::binary : std::ios::in);
+    if (!in.is_open()) {
+        std::cerr << "Unable to open layout " << path << std::endl;
+        return false;
+    }
+
+    int fieldRows = numRows - 2; // Last two rows never hold mines
+    clearMines(mineLocations, fieldRows, numCols);
+    numMines = 0;
+
+    switch (format) {
+        case BITMAP:
+            return loadBitmap(in, mineLocations, fieldRows, numCols, numMines);
+        case COORD_LIST:
+            return loadCoordList(in, mineLocations, fieldRows, numCols, numMines);
+        default:
+            return loadTextGrid(in, mineLocations, fieldRows, numCols, numMines);
+    }
+}
+
+bool saveLayout(const std::string& path, const vector<vector<bool>>& mineLocations, int numRows, int numCols) {
+    LayoutFormat format = formatFromPath(path);
+    std::ofstream out(path, format == BITMAP ? (std::ios::binary | std::ios::trunc) : std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Unable to open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    int fieldRows = numRows - 2;
+
+    if (format == BITMAP) {
+        std::vector<char> buffer;
+        buffer.reserve(BUFFER_SIZE);
+        unsigned char byte = 0;
+        int bit = 0;
+        for (int i = 0; i < fieldRows; ++i) {
+            for (int j = 0; j < numCols; ++j) {
+                if (mineLocations[i][j]) {
+                    byte |= (1 << bit);
+                }
+                if (++bit == 8) {
+                    buffer.push_back(static_cast<char>(byte));
+                    byte = 0;
+                    bit = 0;
+                    if (buffer.size() == BUFFER_SIZE) {
+                        out.write(buffer.data(), buffer.size());
+                        buffer.clear();
+                    }
+                }
+            }
+        }
+        if (bit > 0) {
+            buffer.push_back(static_cast<char>(byte));
+        }
+        out.write(buffer.data(), buffer.size());
+    } else if (format == COORD_LIST) {
+        for (int i = 0; i < fieldRows; ++i) {
+            for (int j = 0; j < numCols; ++j) {
+                if (mineLocations[i][j]) {
+                    out << i << " " << j << "\n";
+                }
+            }
+        }
+    } else {
+        std::string rowText(numCols, '.');
+        for (int i = 0; i < fieldRows; ++i) {
+            for (int j = 0; j < numCols; ++j) {
+                rowText[j] = mineLocations[i][j] ? '*' : '.';
+            }
+            out << rowText << "\n";
+        }
+    }
+
+    return out.good();
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Mine layouts can be loaded from / saved to three formats, picked by extension:
+//   .txt (or anything else)  text grid, one line per row, '*' or '1' is a mine
+//   .bin                     packed bitmap, 1 bit per cell, row-major, LSB first
+//   .coords / .csv           one "row col" (or "row,col") pair per line
+// Only the playable rows (numRows - 2) are read or written, same as placeMines.
+// Text grids and bitmaps must cover that whole field exactly; a short, long or
+// malformed file is reported on std::cerr and loadLayout returns false.
+// mineLocations is cleared first, so it is not usable after a failed load.
+
+bool loadLayout(const std::string& path, vector<vector<bool>>& mineLocations, int numRows, int numCols, int& numMines);
+
+bool saveLayout(const std::string& path, const vector<vector<bool>>& mineLocations, int numRows, int numCols);
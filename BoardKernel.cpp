@@ -0,0 +1,80 @@
+#include <algorithm>
+
+#include "BoardKernel.h"
+
+RuntimeBoardKernel::RuntimeBoardKernel(int numRows, int numCols)
+    : fieldRows(numRows - 2), numCols(numCols),
+      mines(fieldRows * numCols, 0), open(fieldRows * numCols, 0),
+      flagged(fieldRows * numCols, 0), counts(fieldRows * numCols, 0) {}
+
+void RuntimeBoardKernel::load(const vector<vector<bool>>& mineLocations) {
+    for (int i = 0; i < fieldRows; ++i) {
+        for (int j = 0; j < numCols; ++j) {
+            mines[i * numCols + j] = mineLocations[i][j];
+        }
+    }
+
+    for (int i = 0; i < fieldRows; ++i) {
+        for (int j = 0; j < numCols; ++j) {
+            int nearbyMines = 0;
+            for (int di = -1; di <= 1; ++di) {
+                for (int dj = -1; dj <= 1; ++dj) {
+                    if ((di != 0 || dj != 0) && inField(i + di, j + dj) && mines[(i + di) * numCols + j + dj]) {
+                        ++nearbyMines;
+                    }
+                }
+            }
+            counts[i * numCols + j] = static_cast<unsigned char>(nearbyMines);
+        }
+    }
+
+    std::fill(open.begin(), open.end(), 0);
+    std::fill(flagged.begin(), flagged.end(), 0);
+}
+
+void RuntimeBoardKernel::setFlag(int row, int col, bool flag) {
+    if (inField(row, col)) {
+        flagged[row * numCols + col] = flag;
+    }
+}
+
+void RuntimeBoardKernel::reveal(int row, int col, vector<pair<int, int>>& opened) {
+    if (!inField(row, col)) {
+        return;
+    }
+    int start = row * numCols + col;
+    if (open[start] || flagged[start]) {
+        return;
+    }
+
+    open[start] = 1;
+    opened.push_back({row, col});
+    stack.clear();
+    stack.push_back(start);
+
+    while (!stack.empty()) {
+        int cell = stack.back();
+        stack.pop_back();
+        if (mines[cell] || counts[cell] > 0) {
+            continue; // Numbers stop the flood
+        }
+
+        int r = cell / numCols;
+        int c = cell % numCols;
+        for (int di = -1; di <= 1; ++di) {
+            for (int dj = -1; dj <= 1; ++dj) {
+                int nr = r + di;
+                int nc = c + dj;
+                if (!inField(nr, nc)) {
+                    continue;
+                }
+                int next = nr * numCols + nc;
+                if (!open[next] && !flagged[next] && !mines[next]) {
+                    open[next] = 1;
+                    opened.push_back({nr, nc});
+                    stack.push_back(next);
+                }
+            }
+        }
+    }
+}
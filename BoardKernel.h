@@ -0,0 +1,187 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Tracks mines, opened cells and flags for the playable rows (numRows - 2) and
+// does the neighbour counting and flood reveal for revealAdjacentTiles.
+// The game loop is a template on the concrete kernel, so these are only called
+// virtually by code off the hot path (FrontierIndex).
+class BoardKernel {
+    public:
+        virtual ~BoardKernel() {}
+
+        // Copies the mines in and clears every opened cell and flag
+        virtual void load(const vector<vector<bool>>& mineLocations) = 0;
+
+        virtual int adjacentMines(int row, int col) const = 0;
+        virtual bool isOpen(int row, int col) const = 0;
+        virtual bool isFlagged(int row, int col) const = 0;
+        virtual void setFlag(int row, int col, bool flag) = 0;
+
+        // Opens (row, col) and, if it has no nearby mines, everything connected to it
+        // that is not flagged. Every newly opened cell is appended to opened.
+        virtual void reveal(int row, int col, vector<pair<int, int>>& opened) = 0;
+
+        virtual int rows() const = 0;
+        virtual int cols() const = 0;
+};
+
+// Board size known at compile time and small enough that the whole field is one
+// 64-bit word. Counts are popcounts of each cell's neighbour mask, done once in
+// load(), and the flood fill grows the opened area one ring per step with shifts.
+// Only the 9x9 preset is dispatched here: the 16x16 and 30x16 fields need several
+// words and their multi-word flood fill was no faster than RuntimeBoardKernel.
+template <int Cols, int Rows>
+class FixedBoardKernel final : public BoardKernel {
+    static const int FIELD_ROWS = Rows - 2;
+    static const int CELLS = Cols * FIELD_ROWS;
+    static_assert(CELLS <= 64, "field must fit in one 64-bit word");
+
+    uint64_t mines;
+    uint64_t open;
+    uint64_t flagged;
+    uint64_t zeroMask; // Safe cells with no nearby mines
+    uint64_t fieldMask;
+    uint64_t notFirstCol;
+    uint64_t notLastCol;
+    uint64_t neighbors[CELLS];
+    unsigned char counts[CELLS];
+
+    static uint64_t bit(int i) { return uint64_t(1) << i; }
+
+    uint64_t dilate(uint64_t m) const {
+        uint64_t h = m | ((m << 1) & notFirstCol) | ((m >> 1) & notLastCol);
+        return (h | (h << Cols) | (h >> Cols)) & fieldMask;
+    }
+
+    static bool inField(int row, int col) {
+        return row >= 0 && col >= 0 && row < FIELD_ROWS && col < Cols;
+    }
+
+    public:
+        FixedBoardKernel() : mines(0), open(0), flagged(0), zeroMask(0) {
+            fieldMask = CELLS == 64 ? ~uint64_t(0) : bit(CELLS % 64) - 1;
+            notFirstCol = 0;
+            notLastCol = 0;
+            for (int i = 0; i < CELLS; ++i) {
+                if (i % Cols != 0) {
+                    notFirstCol |= bit(i);
+                }
+                if (i % Cols != Cols - 1) {
+                    notLastCol |= bit(i);
+                }
+            }
+            for (int i = 0; i < CELLS; ++i) {
+                neighbors[i] = dilate(bit(i)) & ~bit(i);
+                counts[i] = 0;
+            }
+        }
+
+        void load(const vector<vector<bool>>& mineLocations) override {
+            mines = 0;
+            for (int i = 0; i < FIELD_ROWS; ++i) {
+                for (int j = 0; j < Cols; ++j) {
+                    if (mineLocations[i][j]) {
+                        mines |= bit(i * Cols + j);
+                    }
+                }
+            }
+            for (int i = 0; i < CELLS; ++i) {
+                counts[i] = static_cast<unsigned char>(__builtin_popcountll(mines & neighbors[i]));
+            }
+            // A cell with no mine on or around it is exactly a cell outside the dilated mines
+            zeroMask = ~dilate(mines) & fieldMask;
+            open = 0;
+            flagged = 0;
+        }
+
+        int adjacentMines(int row, int col) const override {
+            return counts[row * Cols + col];
+        }
+
+        bool isOpen(int row, int col) const override {
+            return (open >> (row * Cols + col)) & 1;
+        }
+
+        bool isFlagged(int row, int col) const override {
+            return (flagged >> (row * Cols + col)) & 1;
+        }
+
+        void setFlag(int row, int col, bool flag) override {
+            if (inField(row, col)) {
+                if (flag) {
+                    flagged |= bit(row * Cols + col);
+                } else {
+                    flagged &= ~bit(row * Cols + col);
+                }
+            }
+        }
+
+        void reveal(int row, int col, vector<pair<int, int>>& opened) override {
+            if (!inField(row, col)) {
+                return;
+            }
+            int start = row * Cols + col;
+            if ((open | flagged) & bit(start)) {
+                return;
+            }
+
+            open |= bit(start);
+            opened.push_back({row, col});
+            if (!(zeroMask & bit(start))) {
+                return; // Number or mine, nothing to flood
+            }
+
+            // Grow the connected empty area first, then one more ring picks up its numbered border
+            uint64_t allowed = ~(open | flagged) & fieldMask;
+            uint64_t reachable = zeroMask & allowed;
+            uint64_t zeros = bit(start);
+            uint64_t frontier = zeros;
+            while (frontier) {
+                uint64_t grown = dilate(frontier) & reachable & ~zeros;
+                zeros |= grown;
+                frontier = grown;
+            }
+            uint64_t region = dilate(zeros) & allowed & ~bit(start);
+            open |= region;
+
+            while (region) {
+                int i = __builtin_ctzll(region);
+                opened.push_back({i / Cols, i % Cols});
+                region &= region - 1;
+            }
+        }
+
+        int rows() const override { return FIELD_ROWS; }
+        int cols() const override { return Cols; }
+};
+
+// Any other board size, one byte per cell and an explicit stack for the flood fill
+class RuntimeBoardKernel final : public BoardKernel {
+    int fieldRows;
+    int numCols;
+    vector<unsigned char> mines;
+    vector<unsigned char> open;
+    vector<unsigned char> flagged;
+    vector<unsigned char> counts;
+    vector<int> stack;
+
+    bool inField(int row, int col) const {
+        return row >= 0 && col >= 0 && row < fieldRows && col < numCols;
+    }
+
+    public:
+        RuntimeBoardKernel(int numRows, int numCols);
+
+        void load(const vector<vector<bool>>& mineLocations) override;
+        int adjacentMines(int row, int col) const override { return counts[row * numCols + col]; }
+        bool isOpen(int row, int col) const override { return open[row * numCols + col]; }
+        bool isFlagged(int row, int col) const override { return flagged[row * numCols + col]; }
+        void setFlag(int row, int col, bool flag) override;
+        void reveal(int row, int col, vector<pair<int, int>>& opened) override;
+
+        int rows() const override { return fieldRows; }
+        int cols() const override { return numCols; }
+};
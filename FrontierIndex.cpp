@@ -0,0 +1,433 @@
+#include <algorithm>
+
+#include "FrontierIndex.h"
+
+static const long long MAX_SEARCH_NODES = 4000000; // Per group, a few tens of milliseconds on the worker
+
+FrontierIndex::FrontierIndex(const BoardKernel& board)
+    : board(board), fieldRows(board.rows()), numCols(board.cols()),
+      inFrontier(fieldRows * numCols, 0), componentOf(fieldRows * numCols, -1),
+      parent(fieldRows * numCols, 0), stamp(fieldRows * numCols, 0),
+      currentStamp(0), nextId(0) {}
+
+void FrontierIndex::reset() {
+    std::fill(inFrontier.begin(), inFrontier.end(), 0);
+    std::fill(componentOf.begin(), componentOf.end(), -1);
+    components.clear();
+    changedComponents.clear();
+    // nextId keeps counting so results for the old board never match a live id
+}
+
+bool FrontierIndex::isFrontierCell(int cell) const {
+    int row = cell / numCols;
+    int col = cell % numCols;
+    if (board.isOpen(row, col) || board.isFlagged(row, col)) {
+        return false;
+    }
+    for (int i = -1; i <= 1; ++i) {
+        for (int j = -1; j <= 1; ++j) {
+            int r = row + i;
+            int c = col + j;
+            if (r >= 0 && c >= 0 && r < fieldRows && c < numCols && board.isOpen(r, c)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int FrontierIndex::find(int cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+void FrontierIndex::dissolve(int id, vector<int>& pool) {
+    auto it = components.find(id);
+    if (it == components.end()) {
+        return;
+    }
+    for (int cell : it->second) {
+        componentOf[cell] = -1;
+        if (stamp[cell] != currentStamp) {
+            stamp[cell] = currentStamp;
+            pool.push_back(cell);
+        }
+    }
+    components.erase(it);
+}
+
+void FrontierIndex::update(const vector<pair<int, int>>& changedCells) {
+    ++currentStamp;
+
+    // Frontier membership can only change on or right next to a changed cell
+    vector<int> touched;
+    for (const auto& changed : changedCells) {
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                int r = changed.first + i;
+                int c = changed.second + j;
+                if (r >= 0 && c >= 0 && r < fieldRows && c < numCols) {
+                    int cell = r * numCols + c;
+                    if (stamp[cell] != currentStamp) {
+                        stamp[cell] = currentStamp;
+                        touched.push_back(cell);
+                    }
+                }
+            }
+        }
+    }
+
+    // Every component near a change is taken apart and rebuilt from its cells
+    ++currentStamp;
+    vector<int> pool;
+    for (int cell : touched) {
+        inFrontier[cell] = isFrontierCell(cell);
+        if (componentOf[cell] != -1) {
+            dissolve(componentOf[cell], pool);
+        }
+        if (inFrontier[cell] && stamp[cell] != currentStamp) {
+            stamp[cell] = currentStamp;
+            pool.push_back(cell);
+        }
+    }
+    for (int cell : pool) {
+        parent[cell] = cell;
+    }
+
+    // Cells sharing a number belong together. Reaching a cell of a component that
+    // was not taken apart yet pulls that whole component into the pool as well.
+    for (size_t k = 0; k < pool.size(); ++k) {
+        int cell = pool[k];
+        if (!inFrontier[cell]) {
+            continue;
+        }
+        int row = cell / numCols;
+        int col = cell % numCols;
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                int nr = row + i;
+                int nc = col + j;
+                if (nr < 0 || nc < 0 || nr >= fieldRows || nc >= numCols || !board.isOpen(nr, nc)) {
+                    continue;
+                }
+                for (int di = -1; di <= 1; ++di) {
+                    for (int dj = -1; dj <= 1; ++dj) {
+                        int qr = nr + di;
+                        int qc = nc + dj;
+                        if (qr < 0 || qc < 0 || qr >= fieldRows || qc >= numCols) {
+                            continue;
+                        }
+                        int other = qr * numCols + qc;
+                        if (!inFrontier[other]) {
+                            continue;
+                        }
+                        if (stamp[other] != currentStamp) {
+                            size_t before = pool.size();
+                            if (componentOf[other] != -1) {
+                                dissolve(componentOf[other], pool);
+                            } else {
+                                stamp[other] = currentStamp;
+                                pool.push_back(other);
+                            }
+                            for (size_t added = before; added < pool.size(); ++added) {
+                                parent[pool[added]] = pool[added];
+                            }
+                        }
+                        parent[find(other)] = find(cell);
+                    }
+                }
+            }
+        }
+    }
+
+    unordered_map<int, int> rootToId;
+    for (int cell : pool) {
+        if (!inFrontier[cell]) {
+            continue;
+        }
+        int root = find(cell);
+        auto it = rootToId.find(root);
+        if (it == rootToId.end()) {
+            it = rootToId.emplace(root, nextId++).first;
+            changedComponents.push_back(it->second);
+        }
+        componentOf[cell] = it->second;
+        components[it->second].push_back(cell);
+    }
+}
+
+vector<FrontierComponent> FrontierIndex::takeChanged() {
+    vector<FrontierComponent> snapshots;
+
+    for (int id : changedComponents) {
+        auto it = components.find(id);
+        if (it == components.end()) {
+            continue; // Rebuilt again before anyone asked for it
+        }
+
+        FrontierComponent component;
+        component.id = id;
+        component.cells = it->second;
+
+        unordered_map<int, int> varOf;
+        for (size_t v = 0; v < component.cells.size(); ++v) {
+            varOf[component.cells[v]] = v;
+        }
+
+        ++currentStamp;
+        for (int cell : component.cells) {
+            int row = cell / numCols;
+            int col = cell % numCols;
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    int nr = row + i;
+                    int nc = col + j;
+                    if (nr < 0 || nc < 0 || nr >= fieldRows || nc >= numCols || !board.isOpen(nr, nc)) {
+                        continue;
+                    }
+                    int number = nr * numCols + nc;
+                    if (stamp[number] == currentStamp) {
+                        continue;
+                    }
+                    stamp[number] = currentStamp;
+
+                    FrontierConstraint constraint;
+                    constraint.mines = board.adjacentMines(nr, nc);
+                    for (int di = -1; di <= 1; ++di) {
+                        for (int dj = -1; dj <= 1; ++dj) {
+                            int qr = nr + di;
+                            int qc = nc + dj;
+                            if (qr < 0 || qc < 0 || qr >= fieldRows || qc >= numCols || (di == 0 && dj == 0)) {
+                                continue;
+                            }
+                            if (board.isFlagged(qr, qc)) {
+                                constraint.mines--;
+                            } else if (!board.isOpen(qr, qc)) {
+                                constraint.vars.push_back(varOf[qr * numCols + qc]);
+                            }
+                        }
+                    }
+                    component.constraints.push_back(constraint);
+                }
+            }
+        }
+
+        snapshots.push_back(component);
+    }
+
+    changedComponents.clear();
+    return snapshots;
+}
+
+// Walks the cells of one group in order, counting for every cell in how many
+// valid assignments it holds a mine. Returns false if it ran out of nodes.
+static bool enumerate(size_t depth, const vector<int>& order, const vector<vector<int>>& constraintsOf,
+                      const vector<FrontierConstraint>& constraints, vector<int>& placed, vector<int>& unassigned,
+                      vector<char>& assignment, vector<double>& mineCounts, double& solutions, long long& nodes) {
+    if (++nodes > MAX_SEARCH_NODES) {
+        return false;
+    }
+    if (depth == order.size()) {
+        solutions += 1;
+        for (int var : order) {
+            mineCounts[var] += assignment[var];
+        }
+        return true;
+    }
+
+    int var = order[depth];
+    for (int value = 0; value <= 1; ++value) {
+        bool valid = true;
+        for (int c : constraintsOf[var]) {
+            placed[c] += value;
+            unassigned[c]--;
+            if (placed[c] > constraints[c].mines || placed[c] + unassigned[c] < constraints[c].mines) {
+                valid = false;
+            }
+        }
+        bool finished = true;
+        if (valid) {
+            assignment[var] = value;
+            finished = enumerate(depth + 1, order, constraintsOf, constraints, placed, unassigned, assignment, mineCounts, solutions, nodes);
+        }
+        for (int c : constraintsOf[var]) {
+            placed[c] -= value;
+            unassigned[c]++;
+        }
+        if (!finished) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ComponentProbabilities solveComponent(const FrontierComponent& component) {
+    ComponentProbabilities result;
+    result.id = component.id;
+    result.cells = component.cells;
+    result.probabilities.assign(component.cells.size(), -1.0f);
+
+    int numVars = component.cells.size();
+    const vector<FrontierConstraint>& constraints = component.constraints;
+
+    vector<vector<int>> constraintsOf(numVars);
+    for (size_t c = 0; c < constraints.size(); ++c) {
+        for (int v : constraints[c].vars) {
+            constraintsOf[v].push_back(c);
+        }
+    }
+
+    // Settle cells a number forces on its own (all mines or all safe) until nothing changes
+    vector<int> known(numVars, -1);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& constraint : constraints) {
+            int remaining = constraint.mines;
+            int unknown = 0;
+            for (int v : constraint.vars) {
+                if (known[v] == -1) {
+                    unknown++;
+                } else {
+                    remaining -= known[v];
+                }
+            }
+            if (remaining < 0 || remaining > unknown) {
+                return result; // The numbers (or the flags) contradict each other
+            }
+            if (unknown > 0 && (remaining == 0 || remaining == unknown)) {
+                for (int v : constraint.vars) {
+                    if (known[v] == -1) {
+                        known[v] = remaining == 0 ? 0 : 1;
+                    }
+                }
+                changed = true;
+            }
+        }
+    }
+
+    // Constraints only count the cells that are still open questions from here on
+    vector<int> placed(constraints.size(), 0);
+    vector<int> unassigned(constraints.size(), 0);
+    for (size_t c = 0; c < constraints.size(); ++c) {
+        for (int v : constraints[c].vars) {
+            if (known[v] == -1) {
+                unassigned[c]++;
+            } else {
+                placed[c] += known[v];
+            }
+        }
+    }
+
+    // What is left falls apart into groups that share no number. Each is enumerated
+    // on its own, in breadth-first order so every number fills up and prunes early.
+    vector<char> visited(numVars, 0);
+    vector<char> assignment(numVars, 0);
+    vector<double> mineCounts(numVars, 0.0);
+    for (int v = 0; v < numVars; ++v) {
+        if (known[v] != -1) {
+            result.probabilities[v] = static_cast<float>(known[v]);
+            continue;
+        }
+        if (visited[v]) {
+            continue;
+        }
+
+        vector<int> order(1, v);
+        visited[v] = 1;
+        for (size_t k = 0; k < order.size(); ++k) {
+            for (int c : constraintsOf[order[k]]) {
+                for (int other : constraints[c].vars) {
+                    if (known[other] == -1 && !visited[other]) {
+                        visited[other] = 1;
+                        order.push_back(other);
+                    }
+                }
+            }
+        }
+
+        double solutions = 0;
+        long long nodes = 0;
+        bool finished = enumerate(0, order, constraintsOf, constraints, placed, unassigned, assignment, mineCounts, solutions, nodes);
+        if (!finished) {
+            continue; // Too big to enumerate, leave the group at -1 rather than guess
+        }
+        if (solutions == 0) {
+            std::fill(result.probabilities.begin(), result.probabilities.end(), -1.0f);
+            return result;
+        }
+        for (int var : order) {
+            result.probabilities[var] = static_cast<float>(mineCounts[var] / solutions);
+        }
+    }
+    return result;
+}
+
+ProbabilityWorker::ProbabilityWorker() : stopping(false) {
+    worker = thread(&ProbabilityWorker::run, this);
+}
+
+ProbabilityWorker::~ProbabilityWorker() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void ProbabilityWorker::run() {
+    while (true) {
+        deque<FrontierComponent> batch;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this] { return stopping || !pending.empty(); });
+            if (stopping) {
+                return;
+            }
+            batch.swap(pending);
+        }
+
+        vector<ComponentProbabilities> solved;
+        for (const auto& component : batch) {
+            solved.push_back(solveComponent(component));
+        }
+
+        lock_guard<mutex> guard(lock);
+        for (auto& probabilities : solved) {
+            results.push_back(std::move(probabilities));
+        }
+    }
+}
+
+void ProbabilityWorker::submit(vector<FrontierComponent> changed) {
+    if (changed.empty()) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        for (auto& component : changed) {
+            pending.push_back(std::move(component));
+        }
+    }
+    wake.notify_one();
+}
+
+void ProbabilityWorker::clear() {
+    lock_guard<mutex> guard(lock);
+    pending.clear();
+    results.clear();
+}
+
+bool ProbabilityWorker::poll(vector<ComponentProbabilities>& out) {
+    unique_lock<mutex> guard(lock, try_to_lock);
+    if (!guard.owns_lock() || results.empty()) {
+        return false;
+    }
+    out.swap(results);
+    results.clear();
+    return true;
+}
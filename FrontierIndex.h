@@ -0,0 +1,101 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "BoardKernel.h"
+
+using namespace std;
+
+// One revealed number: how many of its hidden, unflagged neighbours (vars, as
+// indices into FrontierComponent::cells) are still mines
+struct FrontierConstraint {
+    vector<int> vars;
+    int mines;
+};
+
+// Frontier cells that share at least one number, directly or through other cells
+struct FrontierComponent {
+    int id;
+    vector<int> cells; // row * cols + col
+    vector<FrontierConstraint> constraints;
+};
+
+struct ComponentProbabilities {
+    int id;
+    vector<int> cells;
+    vector<float> probabilities; // Mine chance per cell, -1 if unknown or the numbers contradict each other
+};
+
+// The frontier is every hidden, unflagged cell next to an opened one. Cells are
+// grouped with union-find into components that share numbers. Each update only
+// rebuilds the components around the cells that changed, so a reveal or a flag
+// costs roughly the size of the components it touches, not the whole board.
+class FrontierIndex {
+    const BoardKernel& board;
+    int fieldRows;
+    int numCols;
+
+    vector<char> inFrontier;
+    vector<int> componentOf; // -1 when the cell is in no component
+    vector<int> parent;      // Union-find, only valid for cells in the current pool
+    vector<int> stamp;       // Dedupe marks, compared against currentStamp
+    int currentStamp;
+
+    unordered_map<int, vector<int>> components;
+    vector<int> changedComponents;
+    int nextId;
+
+    bool isFrontierCell(int cell) const;
+    int find(int cell);
+    void dissolve(int id, vector<int>& pool);
+
+    public:
+        explicit FrontierIndex(const BoardKernel& board);
+
+        // Forget everything, call after board.load()
+        void reset();
+
+        // Call after cells were opened, flagged or unflagged on the board
+        void update(const vector<pair<int, int>>& changedCells);
+
+        // Snapshots of components built since the last call, ready for the solver
+        vector<FrontierComponent> takeChanged();
+
+        bool isAlive(int id) const { return components.count(id) > 0; }
+};
+
+// Mine probability for every cell of a component, by enumerating the assignments
+// that satisfy its numbers. Forced cells are settled first and the rest is split
+// into groups that share no number. A group too big to enumerate is left at -1
+// so the overlay skips it. Only the numbers are used, not the total mine count.
+ComponentProbabilities solveComponent(const FrontierComponent& component);
+
+// Runs solveComponent on a background thread. submit() and poll() only ever hold
+// the lock for a swap, and poll() gives up instead of waiting if it is busy, so
+// the render loop never blocks on a solve.
+class ProbabilityWorker {
+    thread worker;
+    mutex lock;
+    condition_variable wake;
+    deque<FrontierComponent> pending;
+    vector<ComponentProbabilities> results;
+    bool stopping;
+
+    void run();
+
+    public:
+        ProbabilityWorker();
+        ~ProbabilityWorker();
+
+        void submit(vector<FrontierComponent> changed);
+
+        // Drops queued work and unread results, for when the board is reset
+        void clear();
+
+        // Moves finished results into out, returns false if there were none or the lock was busy
+        bool poll(vector<ComponentProbabilities>& out);
+};
@@ -0,0 +1,103 @@
+// Times the fixed-size 9x9 board kernel against the runtime one on the same preset.
+// Build without SFML:  g++ -O2 -std=c++14 benchmark.cpp BoardKernel.cpp -o benchmark
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <algorithm>
+#include "BoardKernel.h"
+
+static void randomMines(vector<vector<bool>>& mineLocations, int numMines, int numRows, int numCols, std::mt19937& generator) {
+    for (auto& row : mineLocations) {
+        std::fill(row.begin(), row.end(), false);
+    }
+    std::uniform_int_distribution<int> rowDistribution(0, numRows - 3);
+    std::uniform_int_distribution<int> colDistribution(0, numCols - 1);
+    int minesPlaced = 0;
+    while (minesPlaced < numMines) {
+        int row = rowDistribution(generator);
+        int col = colDistribution(generator);
+        if (!mineLocations[row][col]) {
+            mineLocations[row][col] = true;
+            minesPlaced++;
+        }
+    }
+}
+
+struct Timing {
+    double load = 1e30;   // Nanoseconds per board, best round
+    double reveal = 1e30;
+};
+
+// Plays each board by clicking every safe cell in order, timing the load and the
+// clicks (single-cell reveals plus flood fills) separately. Templated on the
+// concrete kernel the same way the game loop is, so nothing goes through a vtable.
+template <class Kernel>
+static void timeKernel(Kernel& board, const vector<vector<vector<bool>>>& boards, Timing& best, long long& checksum) {
+    typedef std::chrono::steady_clock Clock;
+    vector<pair<int, int>> opened;
+    Clock::duration loadTime(0);
+    Clock::duration revealTime(0);
+
+    for (const auto& mineLocations : boards) {
+        auto start = Clock::now();
+        board.load(mineLocations);
+        auto loaded = Clock::now();
+        for (int i = 0; i < board.rows(); ++i) {
+            for (int j = 0; j < board.cols(); ++j) {
+                if (!mineLocations[i][j]) {
+                    opened.clear();
+                    board.reveal(i, j, opened);
+                    for (const auto& cell : opened) {
+                        checksum += board.adjacentMines(cell.first, cell.second);
+                    }
+                }
+            }
+        }
+        auto done = Clock::now();
+        loadTime += loaded - start;
+        revealTime += done - loaded;
+    }
+
+    best.load = std::min(best.load, std::chrono::duration<double, std::nano>(loadTime).count() / boards.size());
+    best.reveal = std::min(best.reveal, std::chrono::duration<double, std::nano>(revealTime).count() / boards.size());
+}
+
+template <class Kernel>
+static void runPreset(const char* name, int numRows, int numCols, int numMines, std::mt19937& generator) {
+    const int boardsPerPreset = 5000;
+    vector<vector<vector<bool>>> boards(boardsPerPreset, vector<vector<bool>>(numRows, vector<bool>(numCols, false)));
+    for (auto& mineLocations : boards) {
+        randomMines(mineLocations, numMines, numRows, numCols, generator);
+    }
+
+    Kernel fixed;
+    RuntimeBoardKernel runtime(numRows, numCols);
+
+    // Best of a few alternating rounds so one noisy round does not decide it
+    Timing fixedTime;
+    Timing runtimeTime;
+    long long fixedChecksum = 0;
+    long long runtimeChecksum = 0;
+    for (int round = 0; round < 5; ++round) {
+        timeKernel(fixed, boards, fixedTime, fixedChecksum);
+        timeKernel(runtime, boards, runtimeTime, runtimeChecksum);
+    }
+
+    std::cout << name << (fixedChecksum == runtimeChecksum ? "" : "  (RESULTS DIFFER)") << std::endl;
+    std::cout << "  load    fixed " << fixedTime.load / 1000.0 << " us, runtime " << runtimeTime.load / 1000.0
+              << " us, speedup " << runtimeTime.load / fixedTime.load << "x" << std::endl;
+    std::cout << "  reveal  fixed " << fixedTime.reveal / 1000.0 << " us, runtime " << runtimeTime.reveal / 1000.0
+              << " us, speedup " << runtimeTime.reveal / fixedTime.reveal << "x" << std::endl;
+    double fixedTotal = fixedTime.load + fixedTime.reveal;
+    double runtimeTotal = runtimeTime.load + runtimeTime.reveal;
+    std::cout << "  total   speedup " << runtimeTotal / fixedTotal << "x" << std::endl;
+}
+
+int main() {
+    std::mt19937 generator(2023);
+
+    runPreset<FixedBoardKernel<9, 9>>("9x9/10", 9, 9, 10, generator);
+
+    return 0;
+}
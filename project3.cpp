@@ -6,6 +6,9 @@
 #include <algorithm>
 #include <sstream>
 #include "TextureManager.h"
+#include "BoardIO.h"
+#include "BoardKernel.h"
+#include "FrontierIndex.h"
 
 void placeMines(vector<vector<bool>>& mineLocations, int numMines, int numRows, int numCols) {
     std::default_random_engine generator(time(0)); // Seed the random number generator
@@ -78,39 +81,21 @@ void drawCount(sf::RenderWindow& window, int countFlags, int numRows, sf::Sprite
     }
 }
 
-void revealAdjacentTiles(std::vector<std::vector<sf::Sprite>>& tiles, std::vector<std::vector<bool>>& mineLocations, int row, int col, int numRows, int numCols, sf::Texture& hiddenTexture, sf::Texture& revealedTexture) {
-    if (row < 0 || col < 0 || row >= numRows - 2 || col >= numCols) {
-        return; // Out of bounds
-    } 
-
-    if (tiles[row][col].getTexture() != &hiddenTexture) {
-        return; // Already revealed or flagged
-    }
-
-    int nearbyMines = 0;
-    
-    // Check neighboring tiles for mines
-    for (int i = -1; i <= 1; ++i) {
-        for (int j = -1; j <= 1; ++j) {
-            int newRow = row + i;
-            int newCol = col + j;
-            if (newRow >= 0 && newCol >= 0 && newRow < numRows - 2 && newCol < numCols && mineLocations[newRow][newCol]) {
-                ++nearbyMines;
-            }
-        }
-    }
-
-    if (nearbyMines > 0) {
-        std::string numberTexturePath = "number_" + std::to_string(nearbyMines);
-        sf::Texture& numberTexture = TextureManager::getTexture(numberTexturePath);
-        tiles[row][col].setTexture(numberTexture);
-    } else {
-        tiles[row][col].setTexture(revealedTexture);
-        // Recursively reveal adjacent tiles
-        for (int i = -1; i <= 1; ++i) {
-            for (int j = -1; j <= 1; ++j) {
-                revealAdjacentTiles(tiles, mineLocations, row + i, col + j, numRows, numCols, hiddenTexture, revealedTexture);
-            }
+template <class Kernel>
+void revealAdjacentTiles(std::vector<std::vector<sf::Sprite>>& tiles, Kernel& board, FrontierIndex& frontier, int row, int col, sf::Texture& revealedTexture) {
+    // The kernel does the bounds checks and the flood fill, this only updates the sprites
+    std::vector<std::pair<int, int>> opened;
+    board.reveal(row, col, opened);
+    frontier.update(opened);
+
+    for (const auto& cell : opened) {
+        int nearbyMines = board.adjacentMines(cell.first, cell.second);
+        if (nearbyMines > 0) {
+            std::string numberTexturePath = "number_" + std::to_string(nearbyMines);
+            sf::Texture& numberTexture = TextureManager::getTexture(numberTexturePath);
+            tiles[cell.first][cell.second].setTexture(numberTexture);
+        } else {
+            tiles[cell.first][cell.second].setTexture(revealedTexture);
         }
     }
 }
@@ -221,127 +206,10 @@ void displayLeaderboardContent(sf::RenderWindow& leaderboardWindow, int numRows,
 
 
 
-int main() {
-
-    std::ifstream txtFile("files/config.cfg");
-
-    if (!txtFile.is_open()) {
-        std::cout << "Unable to open file.\n";
-        return 1;
-    }
-
-    int rowCount, colCount, numOfMines;
-
-    txtFile >> colCount >> rowCount >> numOfMines;
-
-    txtFile.close();
-
-
-    sf::RenderWindow welcomeWindow(sf::VideoMode((colCount*32), (rowCount*32)+100), "Minesweeper");
-
-    sf::Font font;
-    if (!font.loadFromFile("files/font.ttf")) {
-    std::cout << "Failed to load font.ttf" << std::endl;
-    return 0;
-    }
-
-    
-    sf::Text welcomeText;
-    sf::Text welcomeText2;
-    sf::Text userTypedName("",font, 18);
-    welcomeText.setString("WELCOME TO MINESWEEPER!");
-    welcomeText.setFont(font);
-    welcomeText.setCharacterSize(24);
-    welcomeText.setStyle(sf::Text::Bold | sf::Text::Underlined);
-    welcomeText.setFillColor(sf::Color::White);
-
-    sf::FloatRect welcomeTextRect = welcomeText.getLocalBounds();
-
-    welcomeText.setOrigin(welcomeTextRect.left + welcomeTextRect.width/2.0f,
-    welcomeTextRect.top + welcomeTextRect.height/2.0f);
-    welcomeText.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 150));
-
-    std::string name;
-    userTypedName.setFillColor(sf::Color::Yellow);
-    
-
-    sf::FloatRect userTypedNameRect = userTypedName.getLocalBounds();
-
-    userTypedName.setOrigin(userTypedNameRect.left + userTypedNameRect.width/2.0f,
-    userTypedNameRect.top + userTypedNameRect.height/2.0f);
-    userTypedName.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 45));
-
-
-    sf::Text cursor;
-    cursor.setFont(font);
-    cursor.setCharacterSize(18);
-    cursor.setFillColor(sf::Color::Yellow);
-    cursor.setString("|");
-    bool showCursor = true;
-
-    welcomeText2.setString("Please enter your name:");
-    welcomeText2.setFont(font);
-    welcomeText2.setCharacterSize(20);
-    welcomeText2.setStyle(sf::Text::Bold);
-    welcomeText2.setFillColor(sf::Color::White);
-
-    sf::FloatRect welcomeText2Rect = welcomeText2.getLocalBounds();
-
-    welcomeText2.setOrigin(welcomeText2Rect.left + welcomeText2Rect.width/2.0f,
-    welcomeText2Rect.top + welcomeText2Rect.height/2.0f);
-    welcomeText2.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 75));
-
-    sf::RenderWindow gameWindow(sf::VideoMode(colCount*32, (rowCount*32)+100), "Minesweeper");
-
-    while(welcomeWindow.isOpen()) {
-        sf::Event event;
-        while(welcomeWindow.pollEvent(event)) {
-            if(event.type == sf::Event::Closed) {
-            welcomeWindow.close();
-            gameWindow.close();
-            }
-  
-
-           if (event.type == sf::Event::TextEntered) {
-                if (event.text.unicode < 128) {
-                    char typed = static_cast<char>(event.text.unicode);
-
-                    if (event.text.unicode == '\b') { // Handle backspace
-                        if (!name.empty())
-                            name.pop_back();
-                    } else if (event.text.unicode != '\b' && name.size() < 10 && std::isalpha(typed)) {
-                        if (name.empty() || (name.back() == ' ' && !isspace(typed))) {
-                            typed = toupper(typed);
-                        } else {
-                            typed = tolower(typed);
-                        }
-                        name += typed;
-                    }
-                    userTypedName.setString(name);
-
-                    sf::FloatRect textRect = userTypedName.getLocalBounds();
-                    userTypedName.setOrigin(textRect.left + textRect.width / 2.0f,
-                    textRect.top + textRect.height / 2.0f);
-                    userTypedName.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 45));
-                }
-            }
-                if (event.key.code == sf::Keyboard::Enter) {
-                    if (!name.empty()){
-                        welcomeWindow.close();
-                    } 
-                }
-            }
-    
-    welcomeWindow.clear(sf::Color::Blue);
-    welcomeWindow.draw(welcomeText);
-    welcomeWindow.draw(welcomeText2);
-    if (showCursor) {
-        cursor.setPosition(userTypedName.findCharacterPos(name.size()));
-        welcomeWindow.draw(cursor);
-    }
-    welcomeWindow.draw(userTypedName);
-    welcomeWindow.display();
-    }
+// Everything after the welcome screen. Templated on the board kernel so the
+// 9x9 preset gets its own copy of the game loop with the fixed-size kernel inlined.
+template <class Kernel>
+int playGame(sf::RenderWindow& gameWindow, sf::Font& font, const std::string& name, int rowCount, int colCount, int numOfMines, const std::string& layoutPath, Kernel& board) {
 
     //TIMER STUFF
 
@@ -410,9 +278,24 @@ int main() {
 
     vector<vector<bool>> flaggedTiles(rowCount - 2, vector<bool>(colCount, false));
 
+    if (!layoutPath.empty()) {
+        if (!loadLayout(layoutPath, mineLocations, rowCount, colCount, numOfMines)) {
+            return 1;
+        }
+    } else {
+        placeMines(mineLocations, numOfMines, rowCount, colCount);
+    }
+
     int countFlags = numOfMines;
 
-    placeMines(mineLocations, numOfMines, rowCount, colCount);
+    board.load(mineLocations);
+
+    // Mine probability overlay, solved off the render thread (toggle with H)
+    FrontierIndex frontier(board);
+    ProbabilityWorker probabilityWorker;
+    vector<ComponentProbabilities> solvedComponents;
+    vector<float> mineChance(board.rows() * colCount, -1.0f);
+    bool showHeatmap = false;
 
     for (int i = 0; i < rowCount; ++i) {
 
@@ -446,6 +329,13 @@ int main() {
             if(event.type == sf::Event::Closed) {
             gameWindow.close();
             }
+            else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::S) {
+                // Save the current mines so the board can be replayed through config.cfg
+                saveLayout("files/saved_layout.txt", mineLocations, rowCount, colCount);
+            }
+            else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::H) {
+                showHeatmap = !showHeatmap;
+            }
             else if(event.type == sf::Event::MouseButtonPressed && gameActive){
                 if (event.mouseButton.button == sf::Mouse::Left){
                     sf::Vector2i mousePos = sf::Mouse::getPosition(gameWindow);
@@ -520,7 +410,7 @@ int main() {
                         // Change the clicked image
                         if (!mineLocations[row][col]) {
                             if (sprites[row][col].getTexture() == &tileHiddenText) {
-                                revealAdjacentTiles(sprites, mineLocations, row, col, rowCount, colCount, tileHiddenText, tileRevealedText);
+                                revealAdjacentTiles(sprites, board, frontier, row, col, tileRevealedText);
                             }
                            if (allNonMineTilesRevealed(sprites, mineLocations, tileHiddenText)) {
                                 //YOU WIN
@@ -566,14 +456,28 @@ int main() {
                             }
                         }
 
-                        for (int i = 0; i < rowCount - 2; ++i) {
-                            for (int j = 0; j < colCount; ++j) {
-                                mineLocations[i][j] = false;
+                        // Resets mines
+                        if (!layoutPath.empty()) {
+                            // Replay the last good layout if the file can no longer be read
+                            vector<vector<bool>> previousMines = mineLocations;
+                            int previousNumOfMines = numOfMines;
+                            if (!loadLayout(layoutPath, mineLocations, rowCount, colCount, numOfMines)) {
+                                std::cerr << "Keeping the previous layout" << std::endl;
+                                mineLocations.swap(previousMines);
+                                numOfMines = previousNumOfMines;
                             }
+                        } else {
+                            for (int i = 0; i < rowCount - 2; ++i) {
+                                for (int j = 0; j < colCount; ++j) {
+                                    mineLocations[i][j] = false;
+                                }
+                            }
+                            placeMines(mineLocations, numOfMines, rowCount, colCount);
                         }
-
-                        // Resets mines
-                        placeMines(mineLocations, numOfMines, rowCount, colCount);
+                        board.load(mineLocations);
+                        frontier.reset();
+                        probabilityWorker.clear();
+                        std::fill(mineChance.begin(), mineChance.end(), -1.0f);
                         // Resets face to "happyface" image
                         happyFaceBttn.setTexture(happyFaceText);
                     }
@@ -597,23 +501,40 @@ int main() {
                     int row = mousePos.y / tileSizeY;
                     int col = mousePos.x / tileSizeX;
 
-                    if (row < rowCount - 2) {
+                    if (row < rowCount - 2 && !board.isOpen(row, col)) {
                         if (!flaggedTiles[row][col]) {
                             // Flag the tile
                             sprites[row][col].setTexture(flagText);
                             flaggedTiles[row][col] = true;
+                            board.setFlag(row, col, true);
                             countFlags--;
                         } else {
                             // Unflag the tile
                             sprites[row][col].setTexture(tileHiddenText); // Remove flag texture
                             flaggedTiles[row][col] = false;
+                            board.setFlag(row, col, false);
                             countFlags++;
                         }
+                        frontier.update({{row, col}});
                     }
                 }  
             }    
         }
 
+        // Hand this frame's changed components to the worker and pick up anything it finished
+        probabilityWorker.submit(frontier.takeChanged());
+        if (probabilityWorker.poll(solvedComponents)) {
+            for (const auto& solved : solvedComponents) {
+                if (!frontier.isAlive(solved.id)) {
+                    continue; // Component was rebuilt since, a newer result is on its way
+                }
+                for (size_t k = 0; k < solved.cells.size(); ++k) {
+                    mineChance[solved.cells[k]] = solved.probabilities[k];
+                }
+            }
+            solvedComponents.clear();
+        }
+
         gameWindow.clear(sf::Color::White);
 
         for (const auto& row : sprites) {
@@ -622,6 +543,22 @@ int main() {
             }
         }
 
+        if (showHeatmap) {
+            // Green is probably safe, red is probably a mine
+            sf::RectangleShape heatCell(sf::Vector2f(tileSizeX, tileSizeY));
+            for (int i = 0; i < board.rows(); ++i) {
+                for (int j = 0; j < colCount; ++j) {
+                    float chance = mineChance[i * colCount + j];
+                    if (chance < 0 || board.isOpen(i, j) || board.isFlagged(i, j)) {
+                        continue;
+                    }
+                    heatCell.setFillColor(sf::Color(static_cast<sf::Uint8>(255 * chance), static_cast<sf::Uint8>(255 * (1 - chance)), 0, 110));
+                    heatCell.setPosition(j * tileSizeX, i * tileSizeY);
+                    gameWindow.draw(heatCell);
+                }
+            }
+        }
+
 
         //this finds the time elapsed, so the current time - the time the window opened.
         auto game_duration = std::chrono::duration_cast<std::chrono::seconds>(chrono::high_resolution_clock::now() - start_time);
@@ -678,4 +615,140 @@ int main() {
     
     
     return 0;
+}
+
+int main() {
+
+    std::ifstream txtFile("files/config.cfg");
+
+    if (!txtFile.is_open()) {
+        std::cout << "Unable to open file.\n";
+        return 1;
+    }
+
+    int rowCount, colCount, numOfMines;
+
+    txtFile >> colCount >> rowCount >> numOfMines;
+
+    // Optional fourth entry: a mine layout file to play instead of random mines
+    std::string layoutPath;
+    txtFile >> layoutPath;
+
+    txtFile.close();
+
+
+    sf::RenderWindow welcomeWindow(sf::VideoMode((colCount*32), (rowCount*32)+100), "Minesweeper");
+
+    sf::Font font;
+    if (!font.loadFromFile("files/font.ttf")) {
+    std::cout << "Failed to load font.ttf" << std::endl;
+    return 0;
+    }
+
+    
+    sf::Text welcomeText;
+    sf::Text welcomeText2;
+    sf::Text userTypedName("",font, 18);
+    welcomeText.setString("WELCOME TO MINESWEEPER!");
+    welcomeText.setFont(font);
+    welcomeText.setCharacterSize(24);
+    welcomeText.setStyle(sf::Text::Bold | sf::Text::Underlined);
+    welcomeText.setFillColor(sf::Color::White);
+
+    sf::FloatRect welcomeTextRect = welcomeText.getLocalBounds();
+
+    welcomeText.setOrigin(welcomeTextRect.left + welcomeTextRect.width/2.0f,
+    welcomeTextRect.top + welcomeTextRect.height/2.0f);
+    welcomeText.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 150));
+
+    std::string name;
+    userTypedName.setFillColor(sf::Color::Yellow);
+    
+
+    sf::FloatRect userTypedNameRect = userTypedName.getLocalBounds();
+
+    userTypedName.setOrigin(userTypedNameRect.left + userTypedNameRect.width/2.0f,
+    userTypedNameRect.top + userTypedNameRect.height/2.0f);
+    userTypedName.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 45));
+
+
+    sf::Text cursor;
+    cursor.setFont(font);
+    cursor.setCharacterSize(18);
+    cursor.setFillColor(sf::Color::Yellow);
+    cursor.setString("|");
+    bool showCursor = true;
+
+    welcomeText2.setString("Please enter your name:");
+    welcomeText2.setFont(font);
+    welcomeText2.setCharacterSize(20);
+    welcomeText2.setStyle(sf::Text::Bold);
+    welcomeText2.setFillColor(sf::Color::White);
+
+    sf::FloatRect welcomeText2Rect = welcomeText2.getLocalBounds();
+
+    welcomeText2.setOrigin(welcomeText2Rect.left + welcomeText2Rect.width/2.0f,
+    welcomeText2Rect.top + welcomeText2Rect.height/2.0f);
+    welcomeText2.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 75));
+
+    sf::RenderWindow gameWindow(sf::VideoMode(colCount*32, (rowCount*32)+100), "Minesweeper");
+
+    while(welcomeWindow.isOpen()) {
+        sf::Event event;
+        while(welcomeWindow.pollEvent(event)) {
+            if(event.type == sf::Event::Closed) {
+            welcomeWindow.close();
+            gameWindow.close();
+            }
+  
+
+           if (event.type == sf::Event::TextEntered) {
+                if (event.text.unicode < 128) {
+                    char typed = static_cast<char>(event.text.unicode);
+
+                    if (event.text.unicode == '\b') { // Handle backspace
+                        if (!name.empty())
+                            name.pop_back();
+                    } else if (event.text.unicode != '\b' && name.size() < 10 && std::isalpha(typed)) {
+                        if (name.empty() || (name.back() == ' ' && !isspace(typed))) {
+                            typed = toupper(typed);
+                        } else {
+                            typed = tolower(typed);
+                        }
+                        name += typed;
+                    }
+                    userTypedName.setString(name);
+
+                    sf::FloatRect textRect = userTypedName.getLocalBounds();
+                    userTypedName.setOrigin(textRect.left + textRect.width / 2.0f,
+                    textRect.top + textRect.height / 2.0f);
+                    userTypedName.setPosition(sf::Vector2f((colCount*32)/2.0f, ((rowCount*32)+100)/2.0f - 45));
+                }
+            }
+                if (event.key.code == sf::Keyboard::Enter) {
+                    if (!name.empty()){
+                        welcomeWindow.close();
+                    } 
+                }
+            }
+    
+    welcomeWindow.clear(sf::Color::Blue);
+    welcomeWindow.draw(welcomeText);
+    welcomeWindow.draw(welcomeText2);
+    if (showCursor) {
+        cursor.setPosition(userTypedName.findCharacterPos(name.size()));
+        welcomeWindow.draw(cursor);
+    }
+    welcomeWindow.draw(userTypedName);
+    welcomeWindow.display();
+    }
+
+    // Pick the board kernel once, the fixed-size one for 9x9 and the runtime-size one otherwise
+    if (colCount == 9 && rowCount == 9) {
+        FixedBoardKernel<9, 9> board;
+        return playGame(gameWindow, font, name, rowCount, colCount, numOfMines, layoutPath, board);
+    }
+
+    RuntimeBoardKernel board(rowCount, colCount);
+    return playGame(gameWindow, font, name, rowCount, colCount, numOfMines, layoutPath, board);
 }
\ No newline at end of file